@@ -13,6 +13,11 @@
       'cflags_cc!': [ '-fno-exceptions', '-fno-rtti' ],
       'cflags_cc+': ['-frtti'],
       'conditions': [
+        ["OS!='win'", {
+          "sources": [
+            "src/collection.cpp"
+          ],
+        }],
         ["OS=='win'", {
           "defines": [
             "_HAS_EXCEPTIONS=1"
@@ -2,8 +2,20 @@
 type Stringable = string | {
     toString: () => string;
 };
+export interface SharedCollectionsOptions {
+    /** Path to the memory-mapped file shared by all processes, e.g. `/dev/shm/myapp-modsecurity` */
+    path: string;
+    /** Capacity of the table (rounded up to a power of two); defaults to 16384 */
+    slots?: number;
+    /** Lifetime of entries not touched by `expirevar`, in seconds; 0 disables expiry; defaults to 3600 */
+    ttl?: number;
+}
+export interface ModSecurityOptions {
+    /** Store the persistent collections (GLOBAL, IP, SESSION, USER, RESOURCE) in shared memory */
+    sharedCollections?: SharedCollectionsOptions;
+}
 export declare class ModSecurity {
-    constructor();
+    constructor(options?: ModSecurityOptions);
     setLogCallback(callback: (message: string) => void): void;
     whoAmI(): string;
 }
@@ -0,0 +1,710 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <ctime>
+#include <limits>
+#include <regex>
+#include <stdexcept>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <modsecurity/variable_value.h>
+#include "collection.h"
+
+namespace {
+
+constexpr std::uint64_t MAGIC       = 0x4c4f435345444f4dULL; // "MODESCOL"
+constexpr std::uint32_t VERSION     = 1;
+constexpr unsigned int  MAX_PROBES  = 128;
+constexpr unsigned int  MAX_SPINS   = 4096;
+constexpr unsigned int  MAX_RETRIES = 4;
+constexpr std::int32_t  STALE_LOCK  = 5;    // seconds
+
+enum : std::uint32_t {
+    HAS_VALUE       = 1,
+    EXPLICIT_EXPIRY = 2
+};
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "std::atomic<std::uint64_t> must be lock-free to be shared between processes");
+
+inline char lower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+bool iequals(const char* a, const char* b, std::size_t len)
+{
+    for (std::size_t i = 0; i < len; ++i) {
+        if (lower(a[i]) != lower(b[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// FNV-1a over the lowercased key: collection keys are case-insensitive
+std::uint64_t hash_key(const std::string& key)
+{
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    for (char c : key) {
+        hash ^= static_cast<unsigned char>(lower(c));
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+std::int64_t now()
+{
+    return static_cast<std::int64_t>(std::time(nullptr));
+}
+
+inline void relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Spins for a while, then sleeps: the writer holding the slot may have been preempted
+inline void backoff(unsigned int& spins)
+{
+    if (spins < MAX_SPINS) {
+        ++spins;
+        relax();
+    } else {
+        struct timespec ts = { 0, 50000 };
+        ::nanosleep(&ts, nullptr);
+    }
+}
+
+/*
+ * Slot data is read by other processes while a writer modifies it (the sequence counter tells the readers to discard
+ * what they have read). To keep these accesses well-defined, slot fields are accessed with relaxed atomic operations.
+ */
+template<typename T>
+inline T load_relaxed(const T& v)
+{
+    return __atomic_load_n(&v, __ATOMIC_RELAXED);
+}
+
+template<typename T>
+inline void store_relaxed(T& v, T x)
+{
+    __atomic_store_n(&v, x, __ATOMIC_RELAXED);
+}
+
+void copy_from_slot(char* dst, const char* src, std::size_t len)
+{
+    for (std::size_t i = 0; i < len; i += sizeof(std::uint64_t)) {
+        auto w = __atomic_load_n(reinterpret_cast<const std::uint64_t*>(src + i), __ATOMIC_RELAXED);
+        std::memcpy(dst + i, &w, std::min(sizeof(w), len - i));
+    }
+}
+
+void copy_to_slot(char* dst, const char* src, std::size_t len)
+{
+    for (std::size_t i = 0; i < len; i += sizeof(std::uint64_t)) {
+        std::uint64_t w = 0;
+        std::memcpy(&w, src + i, std::min(sizeof(w), len - i));
+        __atomic_store_n(reinterpret_cast<std::uint64_t*>(dst + i), w, __ATOMIC_RELAXED);
+    }
+}
+
+inline std::uint32_t sequence(std::uint64_t word)
+{
+    return static_cast<std::uint32_t>(word);
+}
+
+// Truncated UNIX time; differences stay correct across wraparounds
+inline std::uint32_t stamp()
+{
+    return static_cast<std::uint32_t>(now());
+}
+
+inline std::uint32_t locked_at(std::uint64_t word)
+{
+    return static_cast<std::uint32_t>(word >> 32);
+}
+
+inline std::uint64_t lock_word(std::uint32_t seq, std::uint32_t time)
+{
+    return (static_cast<std::uint64_t>(time) << 32) | seq;
+}
+
+std::system_error os_error(const char* what)
+{
+    return std::system_error(errno, std::generic_category(), what);
+}
+
+}
+
+struct SharedStorage::Header {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t slot_size;
+    std::uint32_t slots;
+    char reserved[44];
+};
+
+struct SharedStorage::Slot {
+    std::atomic<std::uint64_t> word;        // low half: sequence (0: never used, odd: write in progress); high half: lock time
+    std::uint64_t hash;
+    std::int64_t expires;                   // UNIX time; 0: never
+    std::uint32_t flags;
+    std::uint16_t key_len;
+    std::uint16_t value_len;
+    char key[KEY_MAX];
+    char value[VALUE_MAX];
+
+    bool dead(std::int64_t t) const { return this->expires != 0 && this->expires <= t; }
+
+    /**
+     * The lock has been held for too long: its owner must have died in the middle of a write. A write takes
+     * microseconds, so only a writer suspended for several seconds (e.g., by a debugger) can be mistaken for a dead one.
+     */
+    static bool stale(std::uint64_t cur)
+    {
+        return (sequence(cur) & 1u) != 0 && static_cast<std::int32_t>(stamp() - locked_at(cur)) >= STALE_LOCK;
+    }
+
+    /**
+     * Waits for the current writer or takes the slot over if the lock is stale. Returns the token for unlock();
+     * `sequence(token) - 1` is 0 if the slot has never been used.
+     */
+    std::uint64_t lock()
+    {
+        for (unsigned int spins = 0; ; backoff(spins)) {
+            auto cur = this->word.load(std::memory_order_relaxed);
+            auto s   = sequence(cur);
+            if ((s & 1u) == 0) {
+                auto token = lock_word(s + 1, stamp());
+                if (this->word.compare_exchange_weak(cur, token, std::memory_order_acquire, std::memory_order_relaxed)) {
+                    // Keep the data stores after the store that makes the sequence odd (smp_wmb() in write_seqcount_begin())
+                    std::atomic_thread_fence(std::memory_order_release);
+                    return token;
+                }
+            } else if (Slot::stale(cur)) {
+                // The entry may be half-written, so it is marked dead: it stays in the probe chain and can be reused by any key
+                auto token = lock_word(s + 2, stamp());
+                if (this->word.compare_exchange_strong(cur, token, std::memory_order_acquire, std::memory_order_relaxed)) {
+                    std::atomic_thread_fence(std::memory_order_release);
+                    store_relaxed(this->flags, std::uint32_t(0));
+                    store_relaxed(this->expires, std::int64_t(1));
+                    store_relaxed(this->value_len, std::uint16_t(0));
+                    return token;
+                }
+            }
+        }
+    }
+
+    void unlock(std::uint64_t token)
+    {
+        auto seq = sequence(token) + 1;
+        // 0 marks a never used slot; skip it when the counter wraps around. If the CAS fails, the slot has been taken
+        // over by another writer, which now owns it
+        this->word.compare_exchange_strong(token, lock_word(seq != 0 ? seq : 2, 0), std::memory_order_release, std::memory_order_relaxed);
+    }
+};
+
+struct SharedStorage::Snapshot {
+    std::uint32_t seq;
+    std::uint32_t flags;
+    std::uint64_t hash;
+    std::int64_t expires;
+    std::uint16_t key_len;
+    std::uint16_t value_len;
+    bool has_key;
+    char key[KEY_MAX];
+    char value[VALUE_MAX];
+
+    bool dead(std::int64_t t) const { return this->expires != 0 && this->expires <= t; }
+
+    bool matches(std::uint64_t h, const std::string& k) const
+    {
+        return this->has_key && this->hash == h && this->key_len == k.size() && iequals(this->key, k.data(), k.size());
+    }
+
+    /**
+     * Takes a consistent copy of the slot. The key (and the value, if `with_value` is set) is copied only when the slot's
+     * hash equals `want`, or always if `want` is null. Waits while a writer holds the slot; returns false only if that
+     * writer is dead, in which case the entry is garbage and the next writer will discard it.
+     */
+    bool load(const Slot& slot, const std::uint64_t* want, bool with_value)
+    {
+        for (unsigned int spins = 0; ; backoff(spins)) {
+            auto cur = slot.word.load(std::memory_order_acquire);
+            auto seq = sequence(cur);
+            if ((seq & 1u) != 0) {
+                if (Slot::stale(cur)) {
+                    return false;
+                }
+
+                continue;
+            }
+
+            this->seq = seq;
+            if (seq == 0) {
+                return true;
+            }
+
+            this->flags     = load_relaxed(slot.flags);
+            this->hash      = load_relaxed(slot.hash);
+            this->expires   = load_relaxed(slot.expires);
+            this->key_len   = std::min<std::uint16_t>(load_relaxed(slot.key_len), KEY_MAX);
+            this->value_len = std::min<std::uint16_t>(load_relaxed(slot.value_len), VALUE_MAX);
+            this->has_key   = !want || *want == this->hash;
+            if (this->has_key) {
+                copy_from_slot(this->key, slot.key, this->key_len);
+                if (with_value) {
+                    copy_from_slot(this->value, slot.value, this->value_len);
+                }
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence(slot.word.load(std::memory_order_relaxed)) == seq) {
+                return true;
+            }
+        }
+    }
+};
+
+std::shared_ptr<SharedStorage> SharedStorage::open(const std::string& path, std::uint32_t slots, std::uint32_t ttl, Logger logger)
+{
+    static_assert(sizeof(Header) == 64, "unexpected header size");
+    static_assert(sizeof(Slot) == 512, "unexpected slot size");
+    static_assert(offsetof(Slot, key) % sizeof(std::uint64_t) == 0 && KEY_MAX % sizeof(std::uint64_t) == 0, "keys are copied in 64-bit words");
+    static_assert(offsetof(Slot, value) % sizeof(std::uint64_t) == 0 && VALUE_MAX % sizeof(std::uint64_t) == 0, "values are copied in 64-bit words");
+
+    if (slots == 0 || slots > MAX_SLOTS) {
+        throw std::range_error("the number of slots must be between 1 and " + std::to_string(MAX_SLOTS));
+    }
+
+    std::uint32_t n = 1;
+    while (n < slots) {
+        n <<= 1;
+    }
+
+    const std::size_t size = sizeof(Header) + static_cast<std::size_t>(n) * sizeof(Slot);
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd == -1) {
+        throw os_error("open() failed");
+    }
+
+    // The lock only serializes initialization between the processes that start at the same time
+    if (::flock(fd, LOCK_EX) == -1) {
+        auto err = os_error("flock() failed");
+        ::close(fd);
+        throw err;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) == -1) {
+        auto err = os_error("fstat() failed");
+        ::close(fd);
+        throw err;
+    }
+
+    const bool created = st.st_size == 0;
+    if (created && ::ftruncate(fd, static_cast<off_t>(size)) == -1) {
+        auto err = os_error("ftruncate() failed");
+        ::close(fd);
+        throw err;
+    }
+
+    if (!created && static_cast<std::size_t>(st.st_size) != size) {
+        ::close(fd);
+        throw std::runtime_error("'" + path + "' holds a table of a different size; remove it or use the same number of slots");
+    }
+
+    void* base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        auto err = os_error("mmap() failed");
+        ::close(fd);
+        throw err;
+    }
+
+    auto header = static_cast<Header*>(base);
+    if (created) {
+        header->version   = VERSION;
+        header->slot_size = sizeof(Slot);
+        header->slots     = n;
+        std::atomic_thread_fence(std::memory_order_release);
+        header->magic     = MAGIC;
+    }
+
+    // The mapping keeps the open file description alive, so closing the descriptor alone would not release the lock
+    ::flock(fd, LOCK_UN);
+    ::close(fd);
+
+    if (header->magic != MAGIC || header->version != VERSION || header->slot_size != sizeof(Slot) || header->slots != n) {
+        ::munmap(base, size);
+        throw std::runtime_error("'" + path + "' does not contain a compatible shared collection table");
+    }
+
+    return std::shared_ptr<SharedStorage>(new SharedStorage(base, size, n, ttl, std::move(logger)));
+}
+
+SharedStorage::SharedStorage(void* base, std::size_t size, std::uint32_t slots, std::uint32_t ttl, Logger logger)
+    : m_base(base),
+      m_size(size),
+      m_slots(reinterpret_cast<Slot*>(static_cast<char*>(base) + sizeof(Header))),
+      m_mask(slots - 1),
+      m_ttl(ttl),
+      m_logger(std::move(logger)),
+      m_last_log(0)
+{
+}
+
+SharedStorage::~SharedStorage()
+{
+    ::munmap(this->m_base, this->m_size);
+}
+
+// A flood of distinct keys must not turn into a flood of log messages
+void SharedStorage::log(const std::string& message)
+{
+    const auto t = now();
+    if (this->m_logger && t != this->m_last_log) {
+        this->m_last_log = t;
+        this->m_logger("Shared collections: " + message);
+    }
+}
+
+/**
+ * Locates the slot for `key` (claiming an empty or dead one if `create` is set), locks it and calls
+ * `apply(slot, now)`. A slot that did not hold a live entry for `key` is reset before the call.
+ * If `create` is set and the probe window has no free slot, the live entry that expires first is evicted.
+ */
+template<typename F>
+bool SharedStorage::modify(const std::string& key, bool create, F apply)
+{
+    if (key.size() > KEY_MAX) {
+        this->log("cannot store '" + key + "': the key is longer than " + std::to_string(KEY_MAX) + " bytes");
+        return false;
+    }
+
+    const auto hash  = hash_key(key);
+    const auto probe = std::min<std::uint32_t>(MAX_PROBES, this->m_mask + 1);
+
+    for (unsigned int attempt = 0; attempt < MAX_RETRIES; ++attempt) {
+        const auto t  = now();
+        Slot* target  = nullptr;
+        Slot* reuse   = nullptr;
+        Slot* victim  = nullptr;
+        auto deadline = std::numeric_limits<std::int64_t>::max();
+        bool found    = false;
+        Snapshot snap;
+
+        for (std::uint32_t i = 0; i < probe; ++i) {
+            Slot& slot = this->m_slots[(hash + i) & this->m_mask];
+            if (!snap.load(slot, &hash, false)) {
+                // Abandoned by a dead writer: the entry is lost, but the slot can be reused once taken over
+                if (!reuse) {
+                    reuse = &slot;
+                }
+
+                continue;
+            }
+
+            if (snap.seq == 0) {
+                target = &slot;
+                break;
+            }
+
+            if (snap.matches(hash, key)) {
+                target = &slot;
+                found  = true;
+                break;
+            }
+
+            if (snap.dead(t)) {
+                if (!reuse) {
+                    reuse = &slot;
+                }
+            } else if (!reuse) {
+                // Entries that never expire are evicted last
+                const auto expires = snap.expires != 0 ? snap.expires : std::numeric_limits<std::int64_t>::max();
+                if (!victim || expires < deadline) {
+                    victim   = &slot;
+                    deadline = expires;
+                }
+            }
+        }
+
+        if (!found) {
+            if (!create) {
+                return false;
+            }
+
+            if (reuse) {
+                target = reuse;
+            }
+        }
+
+        const bool evict = !target && victim;
+        if (evict) {
+            target = victim;
+        }
+
+        if (!target) {
+            return false;
+        }
+
+        const auto token = target->lock();
+        const auto seq   = sequence(token) - 1;
+
+        // Another process may have changed the slot between the probe and the lock
+        const bool mine  = seq != 0 && target->hash == hash && target->key_len == key.size() && iequals(target->key, key.data(), key.size());
+        const bool alive = mine && !target->dead(t);
+        std::string evicted;
+        if (!mine) {
+            if (!create || (seq != 0 && !target->dead(t) && !evict)) {
+                target->unlock(token);
+                continue;
+            }
+
+            if (seq != 0 && !target->dead(t)) {
+                evicted.assign(target->key, std::min<std::size_t>(target->key_len, KEY_MAX));
+            }
+
+            store_relaxed(target->hash, hash);
+            store_relaxed(target->key_len, static_cast<std::uint16_t>(key.size()));
+            copy_to_slot(target->key, key.data(), key.size());
+        } else if (!alive && !create) {
+            // Leave the dead entry untouched so that it remains reusable
+            target->unlock(token);
+            return false;
+        }
+
+        if (!alive) {
+            store_relaxed(target->flags, std::uint32_t(0));
+            store_relaxed(target->expires, std::int64_t(0));
+            store_relaxed(target->value_len, std::uint16_t(0));
+        }
+
+        const bool result = apply(*target, t);
+        target->unlock(token);
+
+        if (!evicted.empty()) {
+            this->log("the table is full; evicted '" + evicted + "' to store '" + key + "'");
+        }
+
+        return result;
+    }
+
+    this->log("cannot store '" + key + "': the slot keeps changing");
+    return false;
+}
+
+bool SharedStorage::find(const std::string& key, std::string& value) const
+{
+    if (key.size() > KEY_MAX) {
+        return false;
+    }
+
+    const auto hash  = hash_key(key);
+    const auto probe = std::min<std::uint32_t>(MAX_PROBES, this->m_mask + 1);
+    Snapshot snap;
+
+    for (std::uint32_t i = 0; i < probe; ++i) {
+        // A slot abandoned by a dead writer holds no usable entry
+        if (!snap.load(this->m_slots[(hash + i) & this->m_mask], &hash, true)) {
+            continue;
+        }
+
+        if (snap.seq == 0) {
+            break;
+        }
+
+        if (snap.matches(hash, key)) {
+            if (snap.dead(now()) || (snap.flags & HAS_VALUE) == 0) {
+                return false;
+            }
+
+            value.assign(snap.value, snap.value_len);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool SharedStorage::store(const std::string& key, const std::string& value)
+{
+    if (value.size() > VALUE_MAX) {
+        this->log("cannot store '" + key + "': the value is longer than " + std::to_string(VALUE_MAX) + " bytes");
+        return false;
+    }
+
+    return this->modify(key, true, [this, &value](Slot& slot, std::int64_t t) {
+        copy_to_slot(slot.value, value.data(), value.size());
+        store_relaxed(slot.value_len, static_cast<std::uint16_t>(value.size()));
+        store_relaxed(slot.flags, slot.flags | HAS_VALUE);
+        // Like SecCollectionTimeout in ModSecurity 2: every write extends the lifetime unless expirevar was used
+        if ((slot.flags & EXPLICIT_EXPIRY) == 0) {
+            store_relaxed(slot.expires, this->m_ttl ? t + this->m_ttl : std::int64_t(0));
+        }
+
+        return true;
+    });
+}
+
+bool SharedStorage::update(const std::string& key, const std::string& value)
+{
+    if (value.size() > VALUE_MAX) {
+        this->log("cannot store '" + key + "': the value is longer than " + std::to_string(VALUE_MAX) + " bytes");
+        return false;
+    }
+
+    return this->modify(key, false, [this, &value](Slot& slot, std::int64_t t) {
+        if ((slot.flags & HAS_VALUE) == 0) {
+            return false;
+        }
+
+        copy_to_slot(slot.value, value.data(), value.size());
+        store_relaxed(slot.value_len, static_cast<std::uint16_t>(value.size()));
+        if ((slot.flags & EXPLICIT_EXPIRY) == 0) {
+            store_relaxed(slot.expires, this->m_ttl ? t + this->m_ttl : std::int64_t(0));
+        }
+
+        return true;
+    });
+}
+
+bool SharedStorage::remove(const std::string& key)
+{
+    return this->modify(key, false, [](Slot& slot, std::int64_t) {
+        // A dead slot keeps its key so that the probe chains stay intact; it can be reused by any key
+        store_relaxed(slot.flags, std::uint32_t(0));
+        store_relaxed(slot.expires, std::int64_t(1));
+        return true;
+    });
+}
+
+bool SharedStorage::expire(const std::string& key, std::int32_t seconds)
+{
+    return this->modify(key, true, [seconds](Slot& slot, std::int64_t t) {
+        store_relaxed(slot.expires, t + seconds);
+        store_relaxed(slot.flags, slot.flags | EXPLICIT_EXPIRY);
+        return true;
+    });
+}
+
+void SharedStorage::scan(const std::string& prefix, const std::function<void(const std::string&, const std::string&)>& callback) const
+{
+    const auto t = now();
+    Snapshot snap;
+
+    for (std::uint32_t i = 0; i <= this->m_mask; ++i) {
+        if (!snap.load(this->m_slots[i], nullptr, true) || snap.seq == 0) {
+            continue;
+        }
+
+        if (snap.dead(t) || (snap.flags & HAS_VALUE) == 0 || snap.key_len < prefix.size() || !iequals(snap.key, prefix.data(), prefix.size())) {
+            continue;
+        }
+
+        callback(
+            std::string(snap.key + prefix.size(), snap.key_len - prefix.size()),
+            std::string(snap.value, snap.value_len)
+        );
+    }
+}
+
+SharedCollection::SharedCollection(const std::string& name, std::shared_ptr<SharedStorage> storage)
+    : modsecurity::collection::Collection(name), m_storage(std::move(storage)), m_prefix(name + ":")
+{
+}
+
+#if MODSECURITY_VERSION_NUM < 30070000
+void SharedCollection::store(std::string key, std::string value)
+{
+    this->m_storage->store(this->m_prefix + key, value);
+}
+#endif
+
+bool SharedCollection::storeOrUpdateFirst(const std::string& key, const std::string& value)
+{
+    return this->m_storage->store(this->m_prefix + key, value);
+}
+
+bool SharedCollection::updateFirst(const std::string& key, const std::string& value)
+{
+    return this->m_storage->update(this->m_prefix + key, value);
+}
+
+void SharedCollection::del(const std::string& key)
+{
+    this->m_storage->remove(this->m_prefix + key);
+}
+
+#if MODSECURITY_VERSION_NUM >= 30070000
+void SharedCollection::setExpiry(const std::string& key, std::int32_t expiry_seconds)
+{
+    this->m_storage->expire(this->m_prefix + key, expiry_seconds);
+}
+#endif
+
+std::unique_ptr<std::string> SharedCollection::resolveFirst(const std::string& var)
+{
+    std::string value;
+    if (this->m_storage->find(this->m_prefix + var, value)) {
+        return std::make_unique<std::string>(std::move(value));
+    }
+
+    return nullptr;
+}
+
+void SharedCollection::resolveSingleMatch(const std::string& var, std::vector<const modsecurity::VariableValue*>* l)
+{
+    std::string value;
+    if (this->m_storage->find(this->m_prefix + var, value)) {
+        l->push_back(new modsecurity::VariableValue(&this->m_name, &var, &value));
+    }
+}
+
+// KeyExclusions is not a part of libmodsecurity's public API, so exclusions cannot be honored here.
+void SharedCollection::resolveMultiMatches(const std::string& var, std::vector<const modsecurity::VariableValue*>* l, modsecurity::variables::KeyExclusions&)
+{
+    if (var.empty()) {
+        this->m_storage->scan(this->m_prefix, [this, l](const std::string& key, const std::string& value) {
+            l->insert(l->begin(), new modsecurity::VariableValue(&this->m_name, &key, &value));
+        });
+
+        return;
+    }
+
+    std::string value;
+    if (this->m_storage->find(this->m_prefix + var, value)) {
+        l->insert(l->begin(), new modsecurity::VariableValue(&this->m_name, &var, &value));
+    }
+}
+
+void SharedCollection::resolveRegularExpression(const std::string& var, std::vector<const modsecurity::VariableValue*>* l, modsecurity::variables::KeyExclusions&)
+{
+    // Keys are matched case-insensitively anyway; ECMAScript has no inline flags
+    const std::string pattern = var.compare(0, 4, "(?i)") == 0 ? var.substr(4) : var;
+
+    try {
+        const std::regex re(pattern, std::regex::ECMAScript | std::regex::icase);
+        this->m_storage->scan(this->m_prefix, [this, l, &re](const std::string& key, const std::string& value) {
+            if (std::regex_search(key, re)) {
+                l->insert(l->begin(), new modsecurity::VariableValue(&this->m_name, &key, &value));
+            }
+        });
+    } catch (const std::regex_error& e) {
+        // Must not propagate into libmodsecurity
+        this->m_storage->log("cannot match '" + this->m_name + ":/" + var + "/': " + e.what());
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef DB37D917_D975_43F7_9803_CB9F81AC8783
+#define DB37D917_D975_43F7_9803_CB9F81AC8783
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <modsecurity/modsecurity.h>
+#include <modsecurity/collection/collection.h>
+
+/**
+ * Fixed-size open addressing hash table living in a memory-mapped file.
+ *
+ * Every process that maps the same file sees the same entries. Slots are guarded by per-slot sequence counters
+ * (seqlocks): readers never write to the table and retry while a writer holds the slot, a writer claims a single slot
+ * with a CAS. A slot left claimed by a process that died mid-write is taken over by the next writer once the lock
+ * is several seconds old.
+ */
+class SharedStorage {
+public:
+    using Logger = std::function<void(const std::string&)>;
+
+    static constexpr std::uint32_t DEFAULT_SLOTS = 16384;
+    static constexpr std::uint32_t MAX_SLOTS     = 1u << 22;
+    static constexpr std::uint32_t DEFAULT_TTL   = 3600;
+    static constexpr std::uint32_t MAX_TTL       = 0x7FFFFFFF;
+    static constexpr std::size_t   KEY_MAX       = 224;
+    static constexpr std::size_t   VALUE_MAX     = 256;
+
+    /**
+     * Maps the table stored in `path`, creating and initializing the file if it is empty.
+     *
+     * `ttl` is the lifetime (in seconds) of the entries that have no explicit expiry; 0 means "never expire".
+     * `logger` receives reports about evicted and rejected entries.
+     * Throws std::system_error if the file cannot be mapped and std::runtime_error if it holds an incompatible table.
+     */
+    static std::shared_ptr<SharedStorage> open(const std::string& path, std::uint32_t slots, std::uint32_t ttl, Logger logger);
+
+    SharedStorage(const SharedStorage&)            = delete;
+    SharedStorage& operator=(const SharedStorage&) = delete;
+    ~SharedStorage();
+
+    bool find(const std::string& key, std::string& value) const;
+    bool store(const std::string& key, const std::string& value);
+    bool update(const std::string& key, const std::string& value);
+    bool remove(const std::string& key);
+    bool expire(const std::string& key, std::int32_t seconds);
+    void scan(const std::string& prefix, const std::function<void(const std::string&, const std::string&)>& callback) const;
+
+    /**
+     * Passes `message` to the logger; messages that arrive less than a second after the previous one are dropped.
+     */
+    void log(const std::string& message);
+
+private:
+    struct Header;
+    struct Slot;
+    struct Snapshot;
+
+    void* m_base;
+    std::size_t m_size;
+    Slot* m_slots;
+    std::uint32_t m_mask;
+    std::uint32_t m_ttl;
+    Logger m_logger;
+    std::int64_t m_last_log;
+
+    SharedStorage(void* base, std::size_t size, std::uint32_t slots, std::uint32_t ttl, Logger logger);
+
+    template<typename F>
+    bool modify(const std::string& key, bool create, F apply);
+};
+
+/**
+ * libmodsecurity collection backed by SharedStorage.
+ *
+ * All collections share one table; keys are prefixed with the collection name.
+ */
+class SharedCollection : public modsecurity::collection::Collection {
+public:
+    SharedCollection(const std::string& name, std::shared_ptr<SharedStorage> storage);
+
+    bool storeOrUpdateFirst(const std::string& key, const std::string& value) override;
+    bool updateFirst(const std::string& key, const std::string& value) override;
+    void del(const std::string& key) override;
+    std::unique_ptr<std::string> resolveFirst(const std::string& var) override;
+    void resolveSingleMatch(const std::string& var, std::vector<const modsecurity::VariableValue*>* l) override;
+    void resolveMultiMatches(const std::string& var, std::vector<const modsecurity::VariableValue*>* l, modsecurity::variables::KeyExclusions& ke) override;
+    void resolveRegularExpression(const std::string& var, std::vector<const modsecurity::VariableValue*>* l, modsecurity::variables::KeyExclusions& ke) override;
+
+    // libmodsecurity 3.0.7 added setExpiry() (expirevar support) and dropped store()
+#if MODSECURITY_VERSION_NUM >= 30070000
+    void setExpiry(const std::string& key, std::int32_t expiry_seconds) override;
+#else
+    void store(std::string key, std::string value) override;
+#endif
+
+private:
+    std::shared_ptr<SharedStorage> m_storage;
+    std::string m_prefix;
+};
+
+#endif /* DB37D917_D975_43F7_9803_CB9F81AC8783 */
@@ -1,10 +1,41 @@
+#include <cmath>
+#include <cstdint>
+#include <exception>
 #include <memory>
+#include <string>
 #include <modsecurity/modsecurity.h>
 #include <modsecurity/rule_message.h>
 #include "engine.h"
+#ifndef _WIN32
+#   include "collection.h"
+#endif
 
 Napi::FunctionReference* ModSecurity::ctor = nullptr;
 
+#ifndef _WIN32
+static std::uint32_t getIntegerOption(Napi::Env env, Napi::Value value, const char* name, std::uint32_t def, std::uint32_t min, std::uint32_t max)
+{
+    if (value.IsUndefined()) {
+        return def;
+    }
+
+    if (!value.IsNumber()) {
+        throw Napi::TypeError::New(env, std::string("ModSecurity::constructor() expects `sharedCollections.") + name + "` to be a number");
+    }
+
+    double v = value.As<Napi::Number>().DoubleValue();
+    if (!std::isfinite(v) || std::trunc(v) != v || v < min || v > max) {
+        throw Napi::RangeError::New(
+            env,
+            std::string("ModSecurity::constructor() expects `sharedCollections.") + name + "` to be an integer between "
+                + std::to_string(min) + " and " + std::to_string(max)
+        );
+    }
+
+    return static_cast<std::uint32_t>(v);
+}
+#endif
+
 void ModSecurity::log_callback(void* data, const void* message)
 {
     auto ref    = static_cast<Napi::ObjectReference*>(data);
@@ -47,6 +78,70 @@ ModSecurity::ModSecurity(const Napi::CallbackInfo& info)
 {
     this->m_modsec.setConnectorInformation("ModSecurity/nodejs");
     this->m_modsec.setServerLogCb(&ModSecurity::log_callback, modsecurity::TextLogProperty);
+
+    if (info.Length() >= 1 && !info[0].IsUndefined()) {
+        auto env = info.Env();
+        if (!info[0].IsObject()) {
+            throw Napi::TypeError::New(env, "ModSecurity::constructor() expects the first argument to be an object");
+        }
+
+        auto options = info[0].As<Napi::Object>();
+        auto shared  = options.Get("sharedCollections");
+        if (!shared.IsUndefined()) {
+            this->useSharedCollections(env, shared);
+        }
+    }
+}
+
+void ModSecurity::useSharedCollections(Napi::Env env, Napi::Value options)
+{
+#ifdef _WIN32
+    throw Napi::Error::New(env, "ModSecurity::constructor(): `sharedCollections` is not supported on Windows");
+#else
+    if (!options.IsObject()) {
+        throw Napi::TypeError::New(env, "ModSecurity::constructor() expects `sharedCollections` to be an object");
+    }
+
+    auto obj   = options.As<Napi::Object>();
+    auto path  = obj.Get("path");
+    auto slots = obj.Get("slots");
+    auto ttl   = obj.Get("ttl");
+
+    if (!path.IsString()) {
+        throw Napi::TypeError::New(env, "ModSecurity::constructor() expects `sharedCollections.path` to be a string");
+    }
+
+    auto numSlots = getIntegerOption(env, slots, "slots", SharedStorage::DEFAULT_SLOTS, 1, SharedStorage::MAX_SLOTS);
+    auto numTTL   = getIntegerOption(env, ttl, "ttl", SharedStorage::DEFAULT_TTL, 0, SharedStorage::MAX_TTL);
+
+    std::shared_ptr<SharedStorage> storage;
+    try {
+        storage = SharedStorage::open(path.As<Napi::String>().Utf8Value(), numSlots, numTTL, [this](const std::string& message) {
+            // Called from the transaction methods, that is, on the JS thread
+            if (!this->m_logger.IsEmpty()) {
+                auto ms = this->Value();
+                this->m_logger.Call(ms, { Napi::String::New(ms.Env(), message) });
+            }
+        });
+    } catch (const std::exception& e) {
+        throw Napi::Error::New(env, e.what());
+    }
+
+    // libmodsecurity owns the collections and deletes them in its destructor
+    modsecurity::collection::Collection** collections[] = {
+        &this->m_modsec.m_global_collection,
+        &this->m_modsec.m_ip_collection,
+        &this->m_modsec.m_session_collection,
+        &this->m_modsec.m_user_collection,
+        &this->m_modsec.m_resource_collection
+    };
+
+    for (auto collection : collections) {
+        auto replacement = new SharedCollection((*collection)->m_name, storage);
+        delete *collection;
+        *collection = replacement;
+    }
+#endif
 }
 
 Napi::Value ModSecurity::setLogCallback(const Napi::CallbackInfo& info)
@@ -21,6 +21,8 @@ private:
     Napi::Value setLogCallback(const Napi::CallbackInfo& info);
     Napi::Value whoAmI(const Napi::CallbackInfo& info);
 
+    void useSharedCollections(Napi::Env env, Napi::Value options);
+
     static void log_callback(void* data, const void* message);
 };
 
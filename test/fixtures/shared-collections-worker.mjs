@@ -0,0 +1,20 @@
+// Runs a single request against a shared collection table and reports the outcome to the parent process.
+// Usage: shared-collections-worker.mjs <table> <rules>
+import { ModSecurity, Rules, Transaction } from '../../index.mjs';
+
+const [path, rulesFile] = process.argv.slice(2);
+
+// The test runner picks up every file under test/; do nothing unless started by the test
+if (path && rulesFile && process.send) {
+    const modsec = new ModSecurity({ sharedCollections: { path, slots: 64 } });
+    const rules = new Rules();
+    rules.loadFromFile(rulesFile);
+
+    const tx = new Transaction(modsec, rules);
+    tx.processConnection('127.0.0.1', 12345, '127.0.0.1', 80);
+    tx.processURI('/index.html', 'GET', '1.1');
+    const res = tx.processRequestHeaders();
+
+    // Close the IPC channel once the message is sent so that the worker can exit
+    process.send(typeof res === 'object' ? res.status : res, () => process.disconnect());
+}
@@ -1,8 +1,156 @@
-import { describe, it } from 'node:test';
-import { match, strictEqual } from 'node:assert/strict';
+import { after, describe, it } from 'node:test';
+import { match, strictEqual, throws } from 'node:assert/strict';
+import { fork } from 'node:child_process';
+import { once } from 'node:events';
+import { rmSync } from 'node:fs';
+import { tmpdir } from 'node:os';
+import { dirname, join } from 'node:path';
+import { setTimeout } from 'node:timers/promises';
+import { fileURLToPath } from 'node:url';
 import { ModSecurity, Rules, Transaction } from '../../index.mjs';
 
+const __dirname = dirname(fileURLToPath(import.meta.url));
+const sharedRules = join(__dirname, '..', 'fixtures', 'shared-collections.conf');
+
+/**
+ * @param {ModSecurity} modsec
+ * @param {Rules} rules
+ * @returns {boolean|import('../../index.mjs').Intervention}
+ */
+function runPhase1(modsec, rules) {
+    const tx = new Transaction(modsec, rules);
+    tx.processConnection('127.0.0.1', 12345, '127.0.0.1', 80);
+    tx.processURI('/index.html', 'GET', '1.1');
+    return tx.processRequestHeaders();
+}
+
+/**
+ * @param {*} res
+ * @param {number} status
+ * @returns {void}
+ */
+function assertBlocked(res, status) {
+    strictEqual(typeof res, 'object');
+    strictEqual(res.status, status);
+}
+
 describe('ModSecurity', () => {
+    describe('constructor', () => {
+        /** @type {string[]} */
+        const tables = [];
+
+        /**
+         * @param {string} name
+         * @returns {string}
+         */
+        const tablePath = (name) => {
+            const path = join(tmpdir(), `node-modsecurity-${process.pid}-${name}.shm`);
+            rmSync(path, { force: true });
+            tables.push(path);
+            return path;
+        };
+
+        after(() => tables.forEach((path) => rmSync(path, { force: true })));
+
+        it('should reject invalid options', () => {
+            const path = tablePath('invalid');
+            // @ts-ignore -- we are testing invalid input
+            throws(() => new ModSecurity('options'), TypeError);
+            // @ts-ignore -- we are testing invalid input
+            throws(() => new ModSecurity({ sharedCollections: {} }), TypeError);
+            // @ts-ignore -- we are testing invalid input
+            throws(() => new ModSecurity({ sharedCollections: { path, slots: '1' } }), TypeError);
+            throws(() => new ModSecurity({ sharedCollections: { path, slots: 0 } }), RangeError);
+            throws(() => new ModSecurity({ sharedCollections: { path, slots: 1.5 } }), RangeError);
+            throws(() => new ModSecurity({ sharedCollections: { path, ttl: -1 } }), RangeError);
+        });
+
+        it('should share persistent collections between instances', () => {
+            const path = tablePath('instances');
+            const rules = new Rules();
+            rules.loadFromFile(sharedRules);
+
+            const first = new ModSecurity({ sharedCollections: { path, slots: 64 } });
+            const second = new ModSecurity({ sharedCollections: { path, slots: 64 } });
+
+            strictEqual(runPhase1(first, rules), true);
+            strictEqual(runPhase1(second, rules), true);
+
+            assertBlocked(runPhase1(first, rules), 429);
+
+            // Per-process collections do not see the shared counter
+            strictEqual(runPhase1(new ModSecurity(), rules), true);
+        });
+
+        it('should share persistent collections between processes', async () => {
+            const path = tablePath('processes');
+            const rules = new Rules();
+            rules.loadFromFile(sharedRules);
+            const modsec = new ModSecurity({ sharedCollections: { path, slots: 64 } });
+
+            strictEqual(runPhase1(modsec, rules), true);
+
+            const worker = fork(join(__dirname, '..', 'fixtures', 'shared-collections-worker.mjs'), [path, sharedRules]);
+            const [[message], [code]] = await Promise.all([once(worker, 'message'), once(worker, 'exit')]);
+            strictEqual(message, true);
+            strictEqual(code, 0);
+
+            // The worker's request is the second one
+            assertBlocked(runPhase1(modsec, rules), 429);
+        });
+
+        it('should expire entries after `ttl` seconds', async () => {
+            const path = tablePath('ttl');
+            const rules = new Rules();
+            rules.add('SecRuleEngine On');
+            rules.add(`SecAction "phase:1,id:1000,nolog,pass,initcol:ip=%{REMOTE_ADDR},setvar:ip.hits=+1"`);
+            rules.add(`SecRule IP:HITS "@gt 1" "phase:1,id:1001,deny,status:429"`);
+            const modsec = new ModSecurity({ sharedCollections: { path, slots: 64, ttl: 2 } });
+
+            strictEqual(runPhase1(modsec, rules), true);
+            assertBlocked(runPhase1(modsec, rules), 429);
+            await setTimeout(3100);
+            strictEqual(runPhase1(modsec, rules), true);
+        });
+
+        it('should support expirevar', async () => {
+            const path = tablePath('expirevar');
+            const rules = new Rules();
+            rules.add('SecRuleEngine On');
+            rules.add(`SecAction "phase:1,id:1000,nolog,pass,initcol:ip=%{REMOTE_ADDR},setvar:ip.hits=+1,expirevar:ip.hits=2"`);
+            rules.add(`SecRule IP:HITS "@gt 1" "phase:1,id:1001,deny,status:429"`);
+            // ttl: 0 disables the default expiry, so only expirevar can remove the counter
+            const modsec = new ModSecurity({ sharedCollections: { path, slots: 64, ttl: 0 } });
+
+            strictEqual(runPhase1(modsec, rules), true);
+            assertBlocked(runPhase1(modsec, rules), 429);
+            await setTimeout(3100);
+            strictEqual(runPhase1(modsec, rules), true);
+        });
+
+        it('should reuse the slots of removed entries', () => {
+            const path = tablePath('reuse');
+            const rules = new Rules();
+            rules.add('SecRuleEngine On');
+            rules.add(`SecAction "phase:1,id:1000,nolog,pass,initcol:ip=%{REMOTE_ADDR},setvar:ip.a=1"`);
+            rules.add(`SecAction "phase:1,id:1001,nolog,pass,setvar:!ip.a"`);
+            rules.add(`SecAction "phase:1,id:1002,nolog,pass,setvar:ip.a=+1"`);
+            rules.add(`SecAction "phase:1,id:1003,nolog,pass,setvar:!ip.a"`);
+            rules.add(`SecAction "phase:1,id:1004,nolog,pass,setvar:ip.b=1"`);
+            rules.add(`SecRule IP:B "@eq 1" "phase:1,id:1005,deny,status:403"`);
+
+            // The table has a single slot, so `ip.b` can only be stored if the slot of `ip.a` is reused
+            const modsec = new ModSecurity({ sharedCollections: { path, slots: 1 } });
+            assertBlocked(runPhase1(modsec, rules), 403);
+        });
+
+        it('should refuse a table of a different size', () => {
+            const path = tablePath('size');
+            new ModSecurity({ sharedCollections: { path, slots: 64 } });
+            throws(() => new ModSecurity({ sharedCollections: { path, slots: 128 } }), /different size/);
+        });
+    });
+
     describe('setLogCallback', () => {
         it('should set a logging callabck', () => {
             const modsec = new ModSecurity();